@@ -0,0 +1,172 @@
+/**
+ * @file async_log.cc
+ * @brief Implementation of the asynchronous logging ring.
+ *
+ * @author agent <agent@local>
+ * @copyright 2026 agent
+ * @license BSD-2-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "async_log.h"
+
+/* Drain thread poll period when the ring is empty */
+static const int LOG_POLL_MS = 5;
+
+static log_record s_ring[LOG_RING_SIZE];
+static std::atomic<unsigned int> s_head(0);   /* Written by producer */
+static std::atomic<unsigned int> s_tail(0);   /* Written by drain thread */
+static std::atomic<unsigned int> s_dropped(0);
+static std::atomic<bool> s_running(false);
+static std::thread s_thread;
+
+/**
+ * @brief Formats one record.
+ *
+ * The format string is split at each conversion; every segment is printed
+ * with its single argument cast to the type the conversion expects.
+ */
+static void log_format(const log_record &rec)
+{
+	const char *p = rec.fmt;
+	unsigned int n = 0;
+	char seg[128];
+
+	while (*p) {
+		const char *pct = strchr(p, '%');
+		if (!pct) {
+			fputs(p, rec.fp);
+			break;
+		}
+		if (pct[1] == '%') {
+			fwrite(p, 1, pct - p + 1, rec.fp);
+			p = pct + 2;
+			continue;
+		}
+
+		/* Find the conversion character */
+		const char *c = pct + 1;
+		int longs = 0;
+		while (*c && !strchr("diouxXcfFeEgGaAs", *c)) {
+			if (*c == 'l') longs++;
+			c++;
+		}
+		if (!*c || n >= rec.nargs) {
+			fputs(p, rec.fp);
+			break;
+		}
+
+		size_t len = c - p + 1;
+		if (len >= sizeof(seg)) len = sizeof(seg) - 1;
+		memcpy(seg, p, len);
+		seg[len] = '\0';
+
+		switch (rec.kind[n]) {
+			case LOG_ARG_STR:
+				fprintf(rec.fp, seg, rec.arg[n].s);
+				break;
+			case LOG_ARG_DOUBLE:
+				if (strchr("fFeEgGaA", *c))
+					fprintf(rec.fp, seg, rec.arg[n].d);
+				else
+					fprintf(rec.fp, seg, (int)rec.arg[n].d);
+				break;
+			default:
+				if (strchr("fFeEgGaA", *c))
+					fprintf(rec.fp, seg, (double)rec.arg[n].i);
+				else if (longs >= 2)
+					fprintf(rec.fp, seg, rec.arg[n].i);
+				else if (longs == 1)
+					fprintf(rec.fp, seg, (long)rec.arg[n].i);
+				else if (strchr("ouxX", *c))
+					fprintf(rec.fp, seg, (unsigned int)rec.arg[n].i);
+				else
+					fprintf(rec.fp, seg, (int)rec.arg[n].i);
+				break;
+		}
+		n++;
+		p = c + 1;
+	}
+}
+
+/** @brief Writes all queued records; returns the number written. */
+static unsigned int log_drain()
+{
+	unsigned int tail = s_tail.load(std::memory_order_relaxed);
+	unsigned int head = s_head.load(std::memory_order_acquire);
+	unsigned int count = head - tail;
+	bool out = false, err = false;
+
+	for (; tail != head; tail++) {
+		const log_record &rec = s_ring[tail & (LOG_RING_SIZE - 1)];
+		log_format(rec);
+		if (rec.fp == stdout) out = true;
+		else err = true;
+	}
+	s_tail.store(tail, std::memory_order_release);
+
+	if (out) fflush(stdout);
+	if (err) fflush(stderr);
+	return count;
+}
+
+static void log_thread()
+{
+	while (s_running.load()) {
+		if (!log_drain())
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_POLL_MS));
+	}
+	log_drain();
+}
+
+void log_start()
+{
+	if (s_running.load())
+		return;
+	s_dropped = 0;
+	s_running.store(true);
+	s_thread = std::thread(log_thread);
+}
+
+void log_stop()
+{
+	if (!s_running.load())
+		return;
+	s_running.store(false);
+	if (s_thread.joinable())
+		s_thread.join();
+
+	unsigned int dropped = s_dropped.exchange(0);
+	if (dropped)
+		fprintf(stderr, "warning: %u log lines dropped (console too slow)\n", dropped);
+}
+
+void log_flush()
+{
+	if (!s_running.load())
+		return;
+	while (s_tail.load(std::memory_order_acquire) != s_head.load(std::memory_order_relaxed))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void log_push(const log_record &rec)
+{
+	if (!s_running.load(std::memory_order_relaxed)) {
+		log_format(rec);
+		fflush(rec.fp);
+		return;
+	}
+
+	unsigned int head = s_head.load(std::memory_order_relaxed);
+	if (head - s_tail.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+		s_dropped++;
+		return;
+	}
+	s_ring[head & (LOG_RING_SIZE - 1)] = rec;
+	s_head.store(head + 1, std::memory_order_release);
+}
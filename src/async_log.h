@@ -0,0 +1,116 @@
+/**
+ * @file async_log.h
+ * @brief Asynchronous logging ring for hot-path diagnostics.
+ *
+ * Hot loops (per-ARFCN power lines, per-burst offsets, FCCH debug output)
+ * must not block on a slow console or serial terminal. log_async() stores
+ * the format string pointer and up to LOG_MAX_ARGS raw arguments in a
+ * fixed-size record of a lock-free single-producer/single-consumer ring.
+ * A background thread formats and writes the records.
+ *
+ * @section Rules
+ *
+ * - Only one producer thread (the main thread) may call log_async().
+ * - Format strings and "%s" arguments must have static lifetime
+ *   (string literals, bi_to_str()).
+ * - When the ring is full the record is dropped, never blocking the caller;
+ *   the drop count is reported by log_stop().
+ * - Call log_flush() before synchronous printf() output that must appear
+ *   after the queued lines.
+ * - Before log_start() (or after log_stop()) log_async() formats inline.
+ *
+ * @author agent <agent@local>
+ * @copyright 2026 agent
+ * @license BSD-2-Clause
+ */
+
+#ifndef __ASYNC_LOG_H__
+#define __ASYNC_LOG_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <type_traits>
+
+/** @brief Maximum number of arguments per record. */
+#define LOG_MAX_ARGS 4
+
+/** @brief Number of records in the ring (power of 2). */
+#define LOG_RING_SIZE 4096
+
+enum log_arg_kind {
+	LOG_ARG_INT,
+	LOG_ARG_DOUBLE,
+	LOG_ARG_STR
+};
+
+/** @brief One preformatted (unformatted) log line. */
+struct log_record {
+	FILE *fp;
+	const char *fmt;
+	uint8_t nargs;
+	uint8_t kind[LOG_MAX_ARGS];
+	union {
+		long long i;
+		double d;
+		const char *s;
+	} arg[LOG_MAX_ARGS];
+};
+
+/** @brief Starts the background drain thread. */
+void log_start();
+
+/** @brief Drains the ring, stops the thread and reports dropped records. */
+void log_stop();
+
+/** @brief Blocks until every queued record has been written. */
+void log_flush();
+
+/** @brief Queues a packed record (see log_async()). */
+void log_push(const log_record &rec);
+
+/*
+ * Argument packing (C++11, no variadic formatting on the hot path).
+ */
+static inline void log_pack(log_record &, unsigned int) { }
+
+template <typename T, typename... Rest>
+static inline void log_pack(log_record &rec, unsigned int n, T v, Rest... rest)
+{
+	static_assert(std::is_arithmetic<T>::value, "log_async: unsupported argument type");
+	if (std::is_floating_point<T>::value) {
+		rec.kind[n] = LOG_ARG_DOUBLE;
+		rec.arg[n].d = (double)v;
+	} else {
+		rec.kind[n] = LOG_ARG_INT;
+		rec.arg[n].i = (long long)v;
+	}
+	log_pack(rec, n + 1, rest...);
+}
+
+template <typename... Rest>
+static inline void log_pack(log_record &rec, unsigned int n, const char *v, Rest... rest)
+{
+	rec.kind[n] = LOG_ARG_STR;
+	rec.arg[n].s = v;
+	log_pack(rec, n + 1, rest...);
+}
+
+/**
+ * @brief Queues a printf-style line for background output.
+ * @param fp   Destination stream (stdout or stderr).
+ * @param fmt  Format string with static lifetime.
+ * @param args Up to LOG_MAX_ARGS integer, floating point or static string arguments.
+ */
+template <typename... Args>
+static inline void log_async(FILE *fp, const char *fmt, Args... args)
+{
+	static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "log_async: too many arguments");
+	log_record rec;
+	rec.fp = fp;
+	rec.fmt = fmt;
+	rec.nargs = (uint8_t)sizeof...(Args);
+	log_pack(rec, 0, args...);
+	log_push(rec);
+}
+
+#endif /* __ASYNC_LOG_H__ */
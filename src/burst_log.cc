@@ -0,0 +1,415 @@
+/**
+ * @file burst_log.cc
+ * @brief Implementation of the binary FCCH candidate log.
+ *
+ * POSIX builds map the log file and grow it with ftruncate(); Windows
+ * builds fall back to buffered stdio writes with the same file format.
+ *
+ * @author agent <agent@local>
+ * @copyright 2026 agent
+ * @license BSD-2-Clause
+ */
+
+#ifdef _WIN32
+#include "win_compat.h"
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "burst_log.h"
+#include "arfcn_freq.h"
+
+static uint64_t now_us()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+burst_log::burst_log()
+{
+	m_idx = NULL;
+	m_hdr = NULL;
+	m_rec = NULL;
+	m_capacity = 0;
+	m_last_index = 0;
+	m_last_arfcn = -1;
+	m_last_gen = 0;
+#ifdef _WIN32
+	m_fp = NULL;
+#else
+	m_fd = -1;
+	m_win = NULL;
+	m_win_len = 0;
+	m_win_first = 0;
+#endif
+}
+
+burst_log::~burst_log()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+int burst_log::map(uint64_t first)
+{
+	m_capacity = first + BURST_LOG_CHUNK;
+	return 0;
+}
+
+int burst_log::open(const char *path)
+{
+	close();
+
+	m_fp = fopen(path, "wb");
+	if (!m_fp) {
+		fprintf(stderr, "error: burst_log: cannot create %s\n", path);
+		return -1;
+	}
+	m_hdr = new burst_log_header();
+	memcpy(m_hdr->magic, BURST_LOG_MAGIC, sizeof(m_hdr->magic));
+	m_hdr->version = BURST_LOG_VERSION;
+	m_hdr->record_size = sizeof(burst_record);
+	fwrite(m_hdr, sizeof(*m_hdr), 1, m_fp);
+
+	m_idx = fopen((std::string(path) + ".idx").c_str(), "wb");
+	if (!m_idx) {
+		fprintf(stderr, "error: burst_log: cannot create %s.idx\n", path);
+		close();
+		return -1;
+	}
+	return 0;
+}
+
+int burst_log::close()
+{
+	if (m_fp) {
+		fseek(m_fp, 0, SEEK_SET);
+		fwrite(m_hdr, sizeof(*m_hdr), 1, m_fp);
+		fclose(m_fp);
+		m_fp = NULL;
+	}
+	delete m_hdr;
+	m_hdr = NULL;
+	if (m_idx) { fclose(m_idx); m_idx = NULL; }
+	return 0;
+}
+
+void burst_log::append(const burst_record &rec)
+{
+	if (!m_fp)
+		return;
+	index(rec);
+	fwrite(&rec, sizeof(rec), 1, m_fp);
+	m_hdr->count++;
+}
+
+#else
+
+/**
+ * @brief Grows the file by one chunk and maps records
+ * [@p first, @p first + BURST_LOG_CHUNK) in place of the previous chunk.
+ */
+int burst_log::map(uint64_t first)
+{
+	uint64_t capacity = first + BURST_LOG_CHUNK;
+	off_t len = (off_t)(sizeof(burst_log_header) + capacity * sizeof(burst_record));
+	off_t start = (off_t)(sizeof(burst_log_header) + first * sizeof(burst_record));
+	off_t base = start - start % (off_t)sysconf(_SC_PAGESIZE);
+
+	if (m_win) {
+		munmap(m_win, m_win_len);
+		m_win = NULL;
+		m_rec = NULL;
+	}
+	if (ftruncate(m_fd, len) < 0) {
+		perror("burst_log: ftruncate");
+		return -1;
+	}
+	void *p = mmap(NULL, (size_t)(len - base), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, base);
+	if (p == MAP_FAILED) {
+		perror("burst_log: mmap");
+		return -1;
+	}
+	m_win = p;
+	m_win_len = (size_t)(len - base);
+	m_win_first = first;
+	m_capacity = capacity;
+	m_rec = (burst_record *)((char *)p + (start - base));
+	return 0;
+}
+
+int burst_log::open(const char *path)
+{
+	close();
+
+	m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0) {
+		fprintf(stderr, "error: burst_log: cannot create %s\n", path);
+		return -1;
+	}
+	if (map(0) < 0) {
+		close();
+		return -1;
+	}
+	void *p = mmap(NULL, sizeof(burst_log_header), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (p == MAP_FAILED) {
+		perror("burst_log: mmap");
+		close();
+		return -1;
+	}
+	m_hdr = (burst_log_header *)p;
+	memcpy(m_hdr->magic, BURST_LOG_MAGIC, sizeof(m_hdr->magic));
+	m_hdr->version = BURST_LOG_VERSION;
+	m_hdr->record_size = sizeof(burst_record);
+	m_hdr->count = 0;
+	m_hdr->dropped = 0;
+
+	m_idx = fopen((std::string(path) + ".idx").c_str(), "wb");
+	if (!m_idx) {
+		fprintf(stderr, "error: burst_log: cannot create %s.idx\n", path);
+		close();
+		return -1;
+	}
+	return 0;
+}
+
+int burst_log::close()
+{
+	if (m_win) {
+		munmap(m_win, m_win_len);
+		m_win = NULL;
+		m_rec = NULL;
+	}
+	if (m_hdr) {
+		off_t len = (off_t)(sizeof(burst_log_header) + m_hdr->count * sizeof(burst_record));
+		munmap(m_hdr, sizeof(burst_log_header));
+		m_hdr = NULL;
+		// Drop the preallocated tail
+		if (ftruncate(m_fd, len) < 0)
+			perror("burst_log: ftruncate");
+	}
+	if (m_fd >= 0) { ::close(m_fd); m_fd = -1; }
+	if (m_idx) { fclose(m_idx); m_idx = NULL; }
+	return 0;
+}
+
+void burst_log::append(const burst_record &rec)
+{
+	if (!m_hdr)
+		return;
+	if (m_hdr->count >= m_capacity) {
+		if (map(m_capacity) < 0) {
+			close();
+			return;
+		}
+	}
+	index(rec);
+	m_rec[m_hdr->count - m_win_first] = rec;
+	m_hdr->count++;
+}
+
+#endif
+
+/**
+ * @brief Adds an index entry when the ARFCN or tune changes, or every
+ * BURST_LOG_INDEX_STRIDE records.
+ */
+void burst_log::index(const burst_record &rec)
+{
+	uint64_t n = m_hdr->count;
+
+	if (n && rec.arfcn == m_last_arfcn && rec.tune_gen == m_last_gen &&
+	    n - m_last_index < BURST_LOG_INDEX_STRIDE)
+		return;
+
+	burst_index_entry e;
+	e.t_us = rec.t_us;
+	e.record = n;
+	e.arfcn = rec.arfcn;
+	e.tune_gen = rec.tune_gen;
+	fwrite(&e, sizeof(e), 1, m_idx);
+
+	m_last_index = n;
+	m_last_arfcn = rec.arfcn;
+	m_last_gen = rec.tune_gen;
+}
+
+void burst_log::log_scan(fcch_detector *d, iio_source *u, unsigned long long buf_pos,
+			 unsigned int found, float correction, float offset_max,
+			 unsigned int source, float lo_shift)
+{
+	const fcch_candidate *c;
+	unsigned int i, n, dropped;
+	burst_record rec;
+
+	if (!m_hdr)
+		return;
+
+	n = d->candidates(&c, &dropped);
+	m_hdr->dropped += dropped;
+	if (n == 0)
+		return;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.t_us = now_us();
+	rec.arfcn = freq_to_arfcn(u->tuned_freq());
+	rec.tune_gen = u->tune_generation();
+	rec.gain_db = u->gain();
+	rec.source = (uint8_t)source;
+
+	// Offsets are logged from the nominal carrier: add back the LO shift
+	// and the coarse ppm pre-correction
+	lo_shift += (float)(u->ppm_correction() * u->tuned_freq() * 1e-6);
+
+	for (i = 0; i < n; i++) {
+		rec.sample_pos = buf_pos + c[i].pos;
+		rec.pm = c[i].pm;
+		rec.offset_hz = c[i].offset - correction + lo_shift;
+		if (!found || i != n - 1)
+			rec.status = BURST_REJECTED_PM;
+		else if (fabsf(c[i].offset - correction) >= offset_max)
+			rec.status = BURST_REJECTED_RANGE;
+		else
+			rec.status = BURST_ACCEPTED;
+		append(rec);
+	}
+}
+
+/*
+ * ---------------------------------------------------------------------------
+ * Reader / CSV converter
+ * ---------------------------------------------------------------------------
+ */
+
+static const char *status_str(unsigned int s)
+{
+	switch (s) {
+		case BURST_ACCEPTED:       return "accepted";
+		case BURST_REJECTED_PM:    return "rejected_pm";
+		case BURST_REJECTED_RANGE: return "rejected_range";
+		default:                   return "unknown";
+	}
+}
+
+static const char *source_str(unsigned int s)
+{
+	switch (s) {
+		case BURST_SRC_SCAN:    return "scan";
+		case BURST_SRC_OFFSET:  return "offset";
+		case BURST_SRC_ACQUIRE: return "acquire";
+		default:                return "unknown";
+	}
+}
+
+/** @brief fseek() to a 64-bit offset (long is 32-bit on Windows and 32-bit hosts). */
+static int seek64(FILE *fp, uint64_t off)
+{
+#ifdef _WIN32
+	return _fseeki64(fp, (__int64)off, SEEK_SET);
+#else
+	return fseeko(fp, (off_t)off, SEEK_SET);
+#endif
+}
+
+static void dump_records(FILE *fp, uint64_t first, uint64_t last,
+			 uint64_t from_us, uint64_t to_us)
+{
+	burst_record rec;
+
+	if (seek64(fp, sizeof(burst_log_header) + first * sizeof(burst_record)) != 0)
+		return;
+	for (uint64_t n = first; n < last; n++) {
+		if (fread(&rec, sizeof(rec), 1, fp) != 1)
+			break;
+		if (rec.t_us < from_us || rec.t_us > to_us)
+			continue;
+		printf("%llu,%d,%u,%llu,%.2f,%.1f,%.1f,%s,%s\n",
+		       (unsigned long long)rec.t_us, rec.arfcn, rec.tune_gen,
+		       (unsigned long long)rec.sample_pos, rec.offset_hz, rec.pm,
+		       rec.gain_db, status_str(rec.status),
+		       source_str(rec.source));
+	}
+}
+
+static bool index_before(const burst_index_entry &e, uint64_t t_us)
+{
+	return e.t_us < t_us;
+}
+
+int burst_log_dump(const char *path, int arfcn, uint64_t from_us, uint64_t to_us)
+{
+	burst_log_header hdr;
+	FILE *fp = fopen(path, "rb");
+
+	if (!fp) {
+		fprintf(stderr, "error: cannot open %s\n", path);
+		return -1;
+	}
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+	    memcmp(hdr.magic, BURST_LOG_MAGIC, sizeof(hdr.magic)) ||
+	    hdr.record_size != sizeof(burst_record)) {
+		fprintf(stderr, "error: %s is not a burst log\n", path);
+		fclose(fp);
+		return -1;
+	}
+	if (hdr.dropped) {
+		fprintf(stderr, "warning: %llu candidates were not recorded (per-scan overflow)\n",
+			(unsigned long long)hdr.dropped);
+	}
+
+	printf("t_us,arfcn,tune_gen,sample_pos,offset_hz,pm,gain_db,status,source\n");
+
+	if (arfcn < 0 && from_us == 0 && to_us == UINT64_MAX) {
+		dump_records(fp, 0, hdr.count, from_us, to_us);
+		fclose(fp);
+		return 0;
+	}
+
+	FILE *idx = fopen((std::string(path) + ".idx").c_str(), "rb");
+	if (!idx) {
+		fprintf(stderr, "error: cannot open %s.idx\n", path);
+		fclose(fp);
+		return -1;
+	}
+
+	std::vector<burst_index_entry> entries;
+	burst_index_entry e;
+	while (fread(&e, sizeof(e), 1, idx) == 1)
+		entries.push_back(e);
+	fclose(idx);
+
+	/*
+	 * Entries are time ordered and each segment holds a single ARFCN.
+	 * Start at the last segment beginning before from_us (it may still
+	 * hold matching records) and stop once a segment starts after to_us.
+	 */
+	size_t i = std::lower_bound(entries.begin(), entries.end(), from_us, index_before)
+		   - entries.begin();
+	if (i > 0)
+		i--;
+
+	for (; i < entries.size(); i++) {
+		if (entries[i].t_us > to_us)
+			break;
+		if (arfcn >= 0 && entries[i].arfcn != arfcn)
+			continue;
+		uint64_t last = (i + 1 < entries.size()) ? entries[i + 1].record : hdr.count;
+		dump_records(fp, entries[i].record, last, from_us, to_us);
+	}
+
+	fclose(fp);
+	return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file burst_log.h
+ * @brief Append-only binary log of every FCCH candidate.
+ *
+ * Each candidate evaluated by fcch_detector::scan(), accepted or rejected,
+ * is stored as a fixed 40-byte record for offline drift analysis. Records
+ * are appended by memcpy into a preallocated, memory-mapped file that
+ * grows in BURST_LOG_CHUNK steps, so logging costs no system call per
+ * burst. Only the header and the current chunk are mapped, so long runs
+ * do not use up the address space of 32-bit hosts. A sidecar index ("<file>.idx") holds one entry per ARFCN/tune
+ * change and every BURST_LOG_INDEX_STRIDE records, allowing lookup by
+ * time and ARFCN without scanning the whole log.
+ *
+ * @section Layout
+ *
+ * @code
+ *  <file>      burst_log_header | burst_record[count] | (preallocated tail)
+ *  <file>.idx  burst_index_entry[] (time ordered)
+ * @endcode
+ *
+ * Offsets are always relative to the nominal carrier: the LO shift of
+ * acquisition steps and the coarse ppm pre-correction are added back, so
+ * records stay comparable across tunes and runs.
+ *
+ * All fields are little-endian host order. Use `kal --dump-log <file>`
+ * (optionally with `-c <chan>`, `--from <t>`, `--to <t>`) to convert a
+ * log to CSV.
+ *
+ * @author agent <agent@local>
+ * @copyright 2026 agent
+ * @license BSD-2-Clause
+ */
+
+#ifndef __BURST_LOG_H__
+#define __BURST_LOG_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "iio_source.h"
+#include "fcch_detector.h"
+
+#define BURST_LOG_MAGIC "KALBLOG1"
+#define BURST_LOG_VERSION 1
+
+/** @brief Records added per file growth step (~2.5 MB). */
+#define BURST_LOG_CHUNK 65536
+
+/** @brief Maximum records between two index entries. */
+#define BURST_LOG_INDEX_STRIDE 1024
+
+/** @brief Candidate verdict. */
+enum burst_status {
+	BURST_ACCEPTED,
+	BURST_REJECTED_PM,      /**< Peak-to-mean below detector threshold */
+	BURST_REJECTED_RANGE    /**< Offset beyond the caller's limit */
+};
+
+/** @brief Which stage produced the record. */
+enum burst_source {
+	BURST_SRC_SCAN,         /**< c0_detect() */
+	BURST_SRC_OFFSET,       /**< offset_detect() */
+	BURST_SRC_ACQUIRE       /**< coarse_acquire() */
+};
+
+struct burst_log_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t count;         /**< Number of valid records */
+	uint64_t dropped;       /**< Candidates not recorded (FCCH_MAX_CANDIDATES overflow) */
+};
+
+struct burst_record {
+	uint64_t t_us;          /**< Wall clock, microseconds since epoch */
+	uint64_t sample_pos;    /**< Stream sample index (GSM rate) */
+	int32_t arfcn;          /**< -1 if unknown */
+	uint32_t tune_gen;      /**< iio_source::tune_generation() */
+	float offset_hz;        /**< Offset from FCCH nominal at the nominal carrier (tuner error removed) */
+	float pm;               /**< Peak-to-mean ratio */
+	float gain_db;
+	uint8_t status;         /**< burst_status */
+	uint8_t source;         /**< burst_source */
+	uint16_t reserved;
+};
+
+struct burst_index_entry {
+	uint64_t t_us;
+	uint64_t record;        /**< First record of the segment */
+	int32_t arfcn;
+	uint32_t tune_gen;
+};
+
+class burst_log {
+public:
+	burst_log();
+	~burst_log();
+
+	/**
+	 * @brief Creates (truncates) a log and its index.
+	 * @param path Log file path; the index is written to path + ".idx".
+	 * @return 0 on success, -1 on failure.
+	 */
+	int open(const char *path);
+
+	/** @brief Trims the preallocated tail and closes both files. */
+	int close();
+
+	/** @brief Appends one record (no-op if not open). */
+	void append(const burst_record &rec);
+
+	/**
+	 * @brief Logs all candidates of the last fcch_detector::scan() call.
+	 * @param d          Detector that ran the scan.
+	 * @param u          Source (position, gain, tune generation, frequency).
+	 * @param buf_pos    Stream index of the scanned buffer's first sample.
+	 * @param found      Return value of scan().
+	 * @param correction Subtracted from the raw tone frequency to get the offset.
+	 * @param offset_max Offsets (before @p lo_shift) at or beyond this are
+	 *                   BURST_REJECTED_RANGE.
+	 * @param source     burst_source.
+	 * @param lo_shift   LO shift of the capture, added back to the logged offset
+	 *                   (as is the source's ppm pre-correction).
+	 */
+	void log_scan(fcch_detector *d, iio_source *u, unsigned long long buf_pos,
+		      unsigned int found, float correction, float offset_max,
+		      unsigned int source, float lo_shift = 0.0f);
+
+private:
+	int map(uint64_t first);
+	void index(const burst_record &rec);
+
+	FILE *m_idx;
+	burst_log_header *m_hdr;
+	burst_record *m_rec;
+	uint64_t m_capacity;
+	uint64_t m_last_index;
+	int32_t m_last_arfcn;
+	uint32_t m_last_gen;
+#ifdef _WIN32
+	FILE *m_fp;
+#else
+	int m_fd;
+	void *m_win;            /**< Mapped chunk (page aligned) */
+	size_t m_win_len;
+	uint64_t m_win_first;   /**< First record of the mapped chunk */
+#endif
+};
+
+/**
+ * @brief Converts a log to CSV on stdout.
+ *
+ * Filters are resolved through the index: only the segments that can hold
+ * matching records are read.
+ *
+ * @param path    Log file path.
+ * @param arfcn   Only dump this ARFCN, or -1 for all.
+ * @param from_us Only dump records at or after this time (us since epoch).
+ * @param to_us   Only dump records at or before this time (us since epoch).
+ * @return 0 on success, -1 on failure.
+ */
+int burst_log_dump(const char *path, int arfcn, uint64_t from_us = 0,
+		   uint64_t to_us = UINT64_MAX);
+
+#endif /* __BURST_LOG_H__ */
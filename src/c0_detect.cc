@@ -15,6 +15,7 @@
 #include <string.h>
 #include <math.h>
 #include <signal.h> // For sig_atomic_t
+#include <algorithm>
 
 #ifdef _WIN32
 #include "win_compat.h"
@@ -30,16 +31,52 @@
 #include "circular_buffer.h"
 #include "fcch_detector.h"
 #include "arfcn_freq.h"
+#include "offset.h"
 #include "util.h"
+#include "async_log.h"
+#include "burst_log.h"
 
 extern int g_verbosity;
 extern int g_show_fft;
 extern volatile sig_atomic_t g_kal_exit_req;
+extern burst_log *g_burst_log;
+extern int g_coarse_acquire;
 
 static const float ERROR_DETECT_OFFSET_MAX = 40e3;
 
 #define MAX_ARFCN 2048 
 
+#define GSM_RATE (1625000.0 / 6.0)
+#define NOTFOUND_MAX 10
+
+/*
+ * Early confirmation during the power sweep.
+ * A channel is confirmed on the spot (while the LO is already there) once
+ * enough channels have been seen to trust the running threshold and its
+ * power is STRONG_FACTOR above it (10 dB in amplitude).
+ */
+#define RUNNING_MIN_CHANS 16
+static const double STRONG_FACTOR = 3.1623;
+
+/*
+ * Wideband (LTE/UMTS) occupancy rejection.
+ * A GSM carrier occupies a single 200 kHz slice; refarmed LTE/UMTS carriers
+ * show up as a plateau of adjacent slices with nearly the same power.
+ * WIDEBAND_MIN_CHANS adjacent ARFCNs above threshold whose powers stay
+ * within WIDEBAND_FLAT_RATIO (6 dB in amplitude) are skipped in pass 2.
+ * The narrowest LTE carrier (1.4 MHz) spans about 6 ARFCNs. A contiguous
+ * GSM allocation can look the same, so one 12-frame FCCH capture is taken
+ * in the middle of each plateau and a detection keeps the block.
+ */
+#define WIDEBAND_MIN_CHANS 6
+static const double WIDEBAND_FLAT_RATIO = 2.0;
+
+/*
+ * Coarse TCXO acquisition is attempted on at most this many carriers, all
+ * GSM-shaped (no flat neighbour), so LTE/UMTS slices cannot use them up.
+ */
+#define ACQ_MAX_CARRIERS 3
+
 static double vectornorm2(const complex *v, const unsigned int len) {
 	unsigned int i;
 	double e = 0.0;
@@ -48,25 +85,321 @@ static double vectornorm2(const complex *v, const unsigned int len) {
 	return e;
 }
 
+// Helper to convert Linear L2 Norm to dBFS
+// Full Scale Reference = 1.0 (Native float32 range -1.0 to 1.0)
+// Accepts l2_norm (sqrt of sum of squares) and sample count
+static double calc_dbfs(double l2_norm, unsigned int len) {
+	if (l2_norm < 1e-9) return -120.0; // Noise floor floor
+	double rms = l2_norm / sqrt((double)len);
+	return 20.0 * log10(rms);
+}
+
+/**
+ * @brief Channel detect threshold: mean of the weakest 60% of the powers.
+ * @param power   Per-channel L2 norms (indexed by ARFCN).
+ * @param spower  Scratch array of at least MAX_ARFCN entries.
+ * @param bi      Band Indicator.
+ * @param last    Only channels up to and including this ARFCN are used.
+ * @param count   Output: number of channels used.
+ * @return Threshold (L2 norm), 0.0 if no channel was used.
+ */
+static double power_threshold(const double *power, float *spower, int bi,
+			      int last, int *count) {
+	int i, chan_count = 0;
+
+	for(i = first_chan(bi); i >= 0 && i <= last; i = next_chan(i, bi)) {
+		if (i < MAX_ARFCN) {
+			spower[chan_count++] = (float)power[i];
+		}
+	}
+	*count = chan_count;
+	if (chan_count == 0)
+		return 0.0;
+
+	sort(spower, chan_count);
+	return avg(spower, chan_count - 4 * chan_count / 10, 0);
+}
+
+/** @brief True if ARFCN @p c is the 200 kHz neighbour above ARFCN @p prev. */
+static bool chan_adjacent(int prev, int c, int bi) {
+	if (prev < 0)
+		return false;
+	return fabs(arfcn_to_freq(c, &bi) - arfcn_to_freq(prev, &bi) - 200e3) < 1e3;
+}
+
+/** @brief True if both powers are above @p a and within WIDEBAND_FLAT_RATIO. */
+static bool chan_flat(double p1, double p2, double a) {
+	if (p1 <= a || p2 <= a)
+		return false;
+	return fmax(p1, p2) <= WIDEBAND_FLAT_RATIO * fmin(p1, p2);
+}
+
+/**
+ * @brief Marks channels above @p a that are flat with an adjacent channel
+ * (part of a multi-ARFCN plateau rather than a single GSM carrier).
+ */
+static void mark_flat(const double *power, int bi, double a, unsigned char *flat) {
+	int i, prev = -1;
+
+	for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
+		if (i >= MAX_ARFCN)
+			continue;
+		if (chan_adjacent(prev, i, bi) && chan_flat(power[prev], power[i], a))
+			flat[prev] = flat[i] = 1;
+		prev = i;
+	}
+}
+
+/**
+ * @brief FCCH presence check on a channel, any offset.
+ *
+ * Only tells GSM from non-GSM occupancy, so the offset is not checked.
+ * Before coarse acquisition (@p wide) a 20+ ppm error can put the tone
+ * outside the resampler passband: one capture is then taken at each
+ * coarse_acquire() LO step. The LO is left wherever the probe stopped.
+ *
+ * @return 1 if an FCCH burst was seen, 0 if not, -1 on source error.
+ */
+static int probe_fcch(iio_source *u, fcch_detector *detector, int chan, int bi,
+		      unsigned int frames_len, bool wide) {
+	unsigned int overruns, b_len, r, k;
+	unsigned long long b_pos;
+	float offset, shift;
+	double freq = arfcn_to_freq(chan, &bi);
+	complex *b;
+
+	for(k = 0; k < (wide ? ACQ_LO_STEPS : 1); k++) {
+		shift = acq_lo_shift(k);
+		if(u->tune(freq, shift) != 0) {
+			if (g_kal_exit_req) return 0;
+			fprintf(stderr, "error: iio_source::tune\n");
+			return -1;
+		}
+
+		do {
+			u->flush();
+			if(u->fill(frames_len, &overruns)) {
+				if (g_kal_exit_req) return 0;
+				fprintf(stderr, "error: iio_source::fill\n");
+				return -1;
+			}
+		} while(overruns);
+
+		b_pos = g_burst_log ? u->read_position() : 0;
+		b = (complex *)u->get_buffer()->peek(&b_len);
+		r = detector->scan(b, b_len, &offset, 0);
+		if (g_burst_log) {
+			g_burst_log->log_scan(detector, u, b_pos, r, GSM_RATE / 4,
+					      ERROR_DETECT_OFFSET_MAX, BURST_SRC_SCAN, shift);
+		}
+		if (r)
+			return 1;
+		if (g_kal_exit_req)
+			return 0;
+	}
+	return 0;
+}
+
+/**
+ * @brief Marks channels belonging to wideband (non-GSM) occupancy.
+ *
+ * Finds runs of at least WIDEBAND_MIN_CHANS adjacent channels above the
+ * detect threshold with a flat power profile, plus one roll-off channel on
+ * each side when it is above threshold but weaker than the plateau. Each
+ * run is probed for FCCH in its middle and kept if GSM is found.
+ *
+ * @param u          Source used for the FCCH probe.
+ * @param detector   FCCH detector used for the probe.
+ * @param frames_len Probe capture length (samples).
+ * @param wide       TCXO error not acquired yet: probe at every LO step.
+ * @param power      Per-channel L2 norms (indexed by ARFCN).
+ * @param bi         Band Indicator.
+ * @param a          Channel detect threshold.
+ * @param wideband   Output: set to 1 for each rejected ARFCN.
+ * @return Number of channels marked, -1 on source error.
+ */
+static int mark_wideband(iio_source *u, fcch_detector *detector, unsigned int frames_len,
+			 bool wide, const double *power, int bi, double a,
+			 unsigned char *wideband) {
+	int chans[MAX_ARFCN];
+	int i, j, k, s, e, count = 0, marked = 0;
+	double lo, hi;
+
+	// Synchronous diagnostics below: queued sweep lines first
+	log_flush();
+
+	for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
+		if (i < MAX_ARFCN) {
+			chans[count++] = i;
+		}
+	}
+
+	j = 0;
+	while (j < count) {
+		if (power[chans[j]] <= a) {
+			j++;
+			continue;
+		}
+
+		lo = hi = power[chans[j]];
+		for(k = j + 1; k < count; k++) {
+			double p = power[chans[k]];
+			if (p <= a || !chan_adjacent(chans[k - 1], chans[k], bi))
+				break;
+			if (fmax(hi, p) > WIDEBAND_FLAT_RATIO * fmin(lo, p))
+				break;
+			lo = fmin(lo, p);
+			hi = fmax(hi, p);
+		}
+
+		if (k - j < WIDEBAND_MIN_CHANS) {
+			j++;
+			continue;
+		}
+
+		// Contiguous GSM allocation rather than LTE/UMTS?
+		int r = probe_fcch(u, detector, chans[(j + k) / 2], bi, frames_len, wide);
+		if (r < 0)
+			return -1;
+		if (g_kal_exit_req)
+			break;
+		if (r > 0) {
+			if(g_verbosity > 0) {
+				fprintf(stderr, "flat block chan %d-%d carries FCCH, keeping\n",
+				   chans[j], chans[k - 1]);
+			}
+			j = k;
+			continue;
+		}
+
+		// Include the carrier skirts (roll-off only: a stronger
+		// neighbour is a separate carrier, e.g. a BCCH next to LTE)
+		s = j;
+		e = k;
+		if (s > 0 && power[chans[s - 1]] > a && power[chans[s - 1]] < lo &&
+		    chan_adjacent(chans[s - 1], chans[s], bi))
+			s--;
+		if (e < count && power[chans[e]] > a && power[chans[e]] < lo &&
+		    chan_adjacent(chans[e - 1], chans[e], bi))
+			e++;
+
+		for(i = s; i < e; i++) {
+			wideband[chans[i]] = 1;
+		}
+		marked += e - s;
+
+		if(g_verbosity > 0) {
+			fprintf(stderr, "wideband occupancy: chan %d-%d (%.1f-%.1fMHz), skipping\n",
+			   chans[s], chans[e - 1],
+			   arfcn_to_freq(chans[s], &bi) / 1e6, arfcn_to_freq(chans[e - 1], &bi) / 1e6);
+		}
+		j = e;
+	}
+
+	return marked;
+}
+
+/**
+ * @brief Runs FCCH detection on the currently tuned channel.
+ *
+ * Retries up to NOTFOUND_MAX captures. A confirmed BTS is printed (and
+ * flushed) immediately so callers piping stdout see it as it is found.
+ *
+ * @return 1 if confirmed, 0 if not found, -1 on source error.
+ */
+static int confirm_chan(iio_source *u, fcch_detector *detector, int i, double freq,
+			unsigned int frames_len, float *effective_offset) {
+	unsigned int overruns, b_len, notfound_count, r;
+	float offset;
+	complex *b;
+	circular_buffer *ub = u->get_buffer();
+
+	if (isatty(1)) {
+		printf("...chan %d (%.1fMHz)\r", i, freq / 1e6);
+		fflush(stdout);
+	}
+
+	for(notfound_count = 0; notfound_count < NOTFOUND_MAX; notfound_count++) {
+		if (g_kal_exit_req) return 0;
+
+		do {
+			u->flush();
+			// Use full capture length for detection
+			if(u->fill(frames_len, &overruns)) {
+				if (g_kal_exit_req) return 0;
+				log_flush();
+				fprintf(stderr, "error: iio_source::fill\n");
+				return -1;
+			}
+		} while(overruns);
+
+		unsigned long long b_pos = g_burst_log ? u->read_position() : 0;
+		b = (complex *)ub->peek(&b_len);
+		r = detector->scan(b, b_len, &offset, 0);
+		if (g_burst_log) {
+			g_burst_log->log_scan(detector, u, b_pos, r, GSM_RATE / 4,
+					      ERROR_DETECT_OFFSET_MAX, BURST_SRC_SCAN);
+		}
+		*effective_offset = offset - GSM_RATE / 4;
+		if(r && (fabsf(*effective_offset) < ERROR_DETECT_OFFSET_MAX)) {
+			// Report the error from the nominal carrier, not the corrected LO
+			*effective_offset += u->ppm_correction() * freq * 1e-6;
+
+			// Recalculate power for the current buffer to match FFT display
+			double current_norm = sqrt(vectornorm2(b, b_len));
+			double current_dbfs = calc_dbfs(current_norm, b_len);
+
+			// Keep queued verbose/debug lines ahead of the result
+			log_flush();
+			printf(" chan: %4d (%.1fMHz ", i, freq / 1e6);
+			display_freq(*effective_offset);
+			printf(") power: %6.1f dBFS\n", current_dbfs);
+			fflush(stdout);
+
+			if (g_show_fft) {
+				// Found a channel, show its spectrum!
+				draw_ascii_fft((std::complex<float>*)b, 2048, 70);
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
 /**
  * @brief Scans for a Base Station (C0 channel) in the specified band.
+ *
+ * The power sweep keeps a running detect threshold; channels clearly above
+ * it are confirmed during the sweep, one channel behind it so that the
+ * lower edge of a flat (wideband) block is not taken for a carrier. The
+ * remaining candidates are confirmed against the final threshold once the
+ * sweep ends, skipping flat multi-ARFCN plateaus (LTE/UMTS carriers).
+ * With a @p max_found limit they are visited strongest first.
+ *
  * @param u Pointer to the HydraSDR source.
  * @param bi Band Indicator.
+ * @param max_found Stop after this many confirmed BTS (0 = scan whole band).
  * @return 0 on success, -1 on failure.
  */
-int c0_detect(iio_source *u, int bi) {
+int c0_detect(iio_source *u, int bi, unsigned int max_found) {
 
-#define GSM_RATE (1625000.0 / 6.0)
-#define NOTFOUND_MAX 10
-
-	int i, chan_count;
-	unsigned int overruns, b_len, frames_len, found_count, notfound_count, r;
+	int i, chan_count, r;
+	unsigned int overruns, b_len, frames_len, found_count;
 	unsigned int power_scan_len; // Short capture for power scan
 	
-	float offset, effective_offset, min_offset, max_offset;
+	float effective_offset, min_offset = 0.0f, max_offset = 0.0f;
 	
 	float spower[MAX_ARFCN];
 	double power[MAX_ARFCN];
+	unsigned char checked[MAX_ARFCN];
+	unsigned char wideband[MAX_ARFCN];
+	unsigned char acq_tried[MAX_ARFCN];
+	unsigned char flat[MAX_ARFCN];
+	int prev_i = -1;
+	int pending = -1; // Strong channel waiting for its upper neighbour
+	bool stop = false;
+	int acq_tries = g_coarse_acquire ? 0 : ACQ_MAX_CARRIERS;
+	bool acquired = false;
 	
 	double freq, sps, n, a;
 	complex *b;
@@ -89,32 +422,87 @@ int c0_detect(iio_source *u, int bi) {
 	power_scan_len = (unsigned int)ceil((8 * 156.25) * sps); 
 	if (power_scan_len < 1024) power_scan_len = 1024; // Minimum safe size
 
-	// Helper to convert Linear L2 Norm to dBFS
-	// Full Scale Reference = 1.0 (Native float32 range -1.0 to 1.0)
-	// Accepts l2_norm (sqrt of sum of squares) and sample count
-	auto calc_dbfs = [&](double l2_norm, unsigned int len) -> double {
-		if (l2_norm < 1e-9) return -120.0; // Noise floor floor
-		double rms = l2_norm / sqrt((double)len);
-		return 20.0 * log10(rms);
-	};
-
 	ub = u->get_buffer();
 
 	memset(power, 0, sizeof(power));
 	memset(spower, 0, sizeof(spower));
+	memset(checked, 0, sizeof(checked));
+	memset(wideband, 0, sizeof(wideband));
+	memset(acq_tried, 0, sizeof(acq_tried));
+	memset(flat, 0, sizeof(flat));
+
+	found_count = 0;
+
+	// Coarse acquisition on the tuned carrier, until one succeeds.
+	// Finding no FCCH is not a verdict on the channel: the fine
+	// confirmation still runs. Returns -1 on source error only.
+	auto acquire = [&](int chan) -> int {
+		if (acq_tries >= ACQ_MAX_CARRIERS)
+			return 0;
+		acq_tries++;
+		acq_tried[chan] = 1;
+		r = coarse_acquire(u, detector);
+		if (r == ACQ_SOURCE_ERROR)
+			return -1;
+		if (r != ACQ_NOT_FOUND) {
+			acq_tries = ACQ_MAX_CARRIERS;
+			acquired = true;
+		}
+		return 0;
+	};
+
+	// Records a confirmed BTS; returns true once the stop condition is met.
+	auto record_found = [&](float eo) -> bool {
+		if (found_count) {
+			min_offset = fmin(min_offset, eo);
+			max_offset = fmax(max_offset, eo);
+		} else {
+			min_offset = max_offset = eo;
+		}
+		found_count++;
+		return max_found && found_count >= max_found;
+	};
+
+	// Confirms a pass 1 candidate (the sweep has moved on: retune).
+	// Returns -1 on source error, 1 once the stop condition is met.
+	auto confirm_early = [&](int chan) -> int {
+		if(g_verbosity > 1) {
+			log_async(stderr, "\tchan %d: %.1f dB over running threshold, confirming\n",
+			   chan, calc_dbfs(power[chan], power_scan_len) - calc_dbfs(a, power_scan_len));
+		}
+		freq = arfcn_to_freq(chan, &bi);
+		if(u->tune(freq) != 0) {
+			if (g_kal_exit_req) return 0;
+			log_flush();
+			fprintf(stderr, "error: iio_source::tune\n");
+			return -1;
+		}
+		checked[chan] = 1;
+		if (acquire(chan) < 0)
+			return -1;
+		if (g_kal_exit_req) return 0;
+		r = confirm_chan(u, detector, chan, freq, frames_len, &effective_offset);
+		if (r < 0)
+			return -1;
+		return (r > 0 && record_found(effective_offset)) ? 1 : 0;
+	};
 
 	if(g_verbosity > 2) {
 		fprintf(stderr, "calculate power in each channel:\n");
 	}
+	printf("%s:\n", bi_to_str(bi));
+	fflush(stdout);
+
 	u->start();
 	u->flush();
 	
-	// --- PASS 1: Power Scan (Fast) ---
+	// --- PASS 1: Power Scan (Fast), confirming clearly strong channels ---
 	for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
 		if (g_kal_exit_req) break;
 
 		// Safety check for array bounds
 		if (i >= MAX_ARFCN) {
+			log_flush();
 			fprintf(stderr, "warning: ARFCN %d exceeds array size, skipping.\n", i);
 			continue;
 		}
@@ -122,6 +510,7 @@ int c0_detect(iio_source *u, int bi) {
 		freq = arfcn_to_freq(i, &bi);
 		if(u->tune(freq) != 0) {
 			if (g_kal_exit_req) break;
+			log_flush();
 			fprintf(stderr, "error: iio_source::tune\n");
 			delete detector;
 			return -1;
@@ -132,6 +521,7 @@ int c0_detect(iio_source *u, int bi) {
 			// Use short capture length
 			if(u->fill(power_scan_len, &overruns)) {
 				if (g_kal_exit_req) break;
+				log_flush();
 				fprintf(stderr, "error: iio_source::fill\n");
 				delete detector;
 				return -1;
@@ -144,114 +534,137 @@ int c0_detect(iio_source *u, int bi) {
 		n = sqrt(vectornorm2(b, power_scan_len)); // Calculate norm over short length
 		power[i] = n;
 		if(g_verbosity > 2) {
-			fprintf(stderr, "\tchan %d (%.1fMHz):\tpower: %6.1f dBFS\n",
+			log_async(stderr, "\tchan %d (%.1fMHz):\tpower: %6.1f dBFS\n",
 			   i, freq / 1e6, calc_dbfs(n, power_scan_len));
 		}
+
+		a = power_threshold(power, spower, bi, i, &chan_count);
+		bool flat_with_prev = chan_adjacent(prev_i, i, bi) && chan_flat(power[prev_i], n, a);
+		prev_i = i;
+
+		// The previous strong channel is not the lower edge of a flat
+		// block: confirm it now (a flat one is left to pass 2)
+		if (pending >= 0) {
+			int c = pending;
+			pending = -1;
+			if (!flat_with_prev) {
+				r = confirm_early(c);
+				if (r < 0) {
+					delete detector;
+					return -1;
+				}
+				if (r > 0) {
+					stop = true;
+					break;
+				}
+				if (g_kal_exit_req) break;
+			}
+		}
+
+		if (chan_count < RUNNING_MIN_CHANS || n <= STRONG_FACTOR * a)
+			continue;
+
+		// Possibly inside a wideband block: leave it to pass 2 classification
+		if (flat_with_prev)
+			continue;
+
+		pending = i;
+	}
+
+	// Last channel of the band: no upper neighbour
+	if (pending >= 0 && !stop && !g_kal_exit_req) {
+		if (confirm_early(pending) < 0) {
+			delete detector;
+			return -1;
+		}
 	}
 	
-	if (g_kal_exit_req) {
+	if (g_kal_exit_req || (max_found && found_count >= max_found)) {
 		delete detector;
 		return 0;
 	}
 
-	chan_count = 0;
-	for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
-		if (i < MAX_ARFCN) {
-		    spower[chan_count++] = (float)power[i];
-		}
-	}
-	sort(spower, chan_count);
-
-	if (chan_count > 0) {
-		a = avg(spower, chan_count - 4 * chan_count / 10, 0);
-	} else {
-		a = 0.0;
-	}
+	a = power_threshold(power, spower, bi, MAX_ARFCN, &chan_count);
+	log_flush();
 
 	if(g_verbosity > 0) {
 		// Threshold calculation uses power_scan_len (from Pass 1)
 		fprintf(stderr, "channel detect threshold: %6.1f dBFS\n", calc_dbfs(a, power_scan_len));
 	}
 
-	// --- PASS 2: FCCH Scan (Precise, on candidates only) ---
-	printf("%s:\n", bi_to_str(bi));
-	found_count = 0;
-	notfound_count = 0;
-	i = first_chan(bi);
-	do {
-		if (g_kal_exit_req) break;
-
-		if (i >= MAX_ARFCN) {
-			i = next_chan(i, bi);
-			continue;
-		}
+	r = mark_wideband(u, detector, frames_len, g_coarse_acquire && !acquired,
+			  power, bi, a, wideband);
+	if (r < 0) {
+		delete detector;
+		return -1;
+	}
+	if(g_verbosity > 0 && r) {
+		fprintf(stderr, "%d channels rejected as wideband (LTE/UMTS) occupancy\n", r);
+	}
 
-		if(power[i] <= a) {
-			i = next_chan(i, bi);
-			continue;
+	// Not acquired during the sweep: use the strongest remaining carriers
+	// that look like a single GSM carrier (short plateaus survive
+	// mark_wideband() and would only waste attempts)
+	mark_flat(power, bi, a, flat);
+	while (acq_tries < ACQ_MAX_CARRIERS && !g_kal_exit_req) {
+		int best = -1;
+		for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
+			if (i >= MAX_ARFCN || checked[i] || acq_tried[i] || wideband[i] || flat[i] ||
+			    power[i] <= a)
+				continue;
+			if (best < 0 || power[i] > power[best])
+				best = i;
 		}
+		if (best < 0)
+			break;
 
-		freq = arfcn_to_freq(i, &bi);
-		if (isatty(1)) {
-			printf("...chan %d (%.1fMHz)\r", i, freq / 1e6);
-			fflush(stdout);
-		}
-		
+		freq = arfcn_to_freq(best, &bi);
 		if(u->tune(freq) != 0) {
 			if (g_kal_exit_req) break;
 			fprintf(stderr, "error: iio_source::tune\n");
 			delete detector;
 			return -1;
 		}
+		// The channel stays a pass 2 candidate whatever the outcome
+		if (acquire(best) < 0) {
+			delete detector;
+			return -1;
+		}
+	}
 
-		do {
-			u->flush();
-			// Use full capture length for detection
-			if(u->fill(frames_len, &overruns)) {
-				if (g_kal_exit_req) break;
-				fprintf(stderr, "error: iio_source::fill\n");
-				delete detector;
-				return -1;
-			}
-		} while(overruns);
-		
-		if (g_kal_exit_req) break;
-
-		b = (complex *)ub->peek(&b_len);
-		r = detector->scan(b, b_len, &offset, 0);
-		effective_offset = offset - GSM_RATE / 4;
-		if(r && (fabsf(effective_offset) < ERROR_DETECT_OFFSET_MAX)) {
-			if (found_count) {
-				min_offset = fmin(min_offset, effective_offset);
-				max_offset = fmax(max_offset, effective_offset);
-			} else {
-				min_offset = max_offset = effective_offset;
-			}
-			found_count++;
-			
-			// Recalculate power for the current buffer to match FFT display
-			double current_norm = sqrt(vectornorm2(b, b_len));
-			double current_dbfs = calc_dbfs(current_norm, b_len);
+	// --- PASS 2: FCCH Scan (Precise, on remaining candidates only) ---
+	int order[MAX_ARFCN], order_count = 0;
+	for(i = first_chan(bi); i >= 0; i = next_chan(i, bi)) {
+		if (i < MAX_ARFCN && !checked[i] && !wideband[i] && power[i] > a)
+			order[order_count++] = i;
+	}
+	// Stopping early: take the strongest (best reference) carriers first
+	if (max_found) {
+		std::stable_sort(order, order + order_count,
+				 [&](int c1, int c2) { return power[c1] > power[c2]; });
+	}
 
-			printf(" chan: %4d (%.1fMHz ", i, freq / 1e6);
-			display_freq(effective_offset);
-			printf(") power: %6.1f dBFS\n", current_dbfs);
+	for(int k = 0; k < order_count; k++) {
+		if (g_kal_exit_req) break;
 
-			if (g_show_fft) {
-				// Found a channel, show its spectrum!
-				draw_ascii_fft((std::complex<float>*)b, 2048, 70);
-			}
+		i = order[k];
+		freq = arfcn_to_freq(i, &bi);
+		if(u->tune(freq) != 0) {
+			if (g_kal_exit_req) break;
+			fprintf(stderr, "error: iio_source::tune\n");
+			delete detector;
+			return -1;
+		}
 
-			notfound_count = 0;
-			i = next_chan(i, bi);
-		} else {
-			notfound_count += 1;
-			if(notfound_count >= NOTFOUND_MAX) {
-				notfound_count = 0;
-				i = next_chan(i, bi);
-			}
+		checked[i] = 1;
+		r = confirm_chan(u, detector, i, freq, frames_len, &effective_offset);
+		if (r < 0) {
+			delete detector;
+			return -1;
 		}
-	} while(i >= 0);
+		if (r > 0 && record_found(effective_offset))
+			break;
+	}
 
 	delete detector;
 	return 0;
@@ -18,6 +18,8 @@
 #include <algorithm>
 
 #include "fcch_detector.h"
+#include "kal_probes.h"
+#include "async_log.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -66,6 +68,8 @@ fcch_detector::fcch_detector(const float sample_rate, const unsigned int D,
 	/* Initialize edge detection state machine (instance variables) */
 	m_lth_count = 0;
 	m_lth_state = 1;  /* HIGH */
+	m_cand_count = 0;
+	m_cand_dropped = 0;
 
 	/* FFTW setup */
 	m_in = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * FFT_SIZE);
@@ -348,6 +352,9 @@ unsigned int fcch_detector::scan(const complex *s, const unsigned int s_len,
 	if (consumed)
 		*consumed = len;
 
+	m_cand_count = 0;
+	m_cand_dropped = 0;
+
 	/* Calculate average error over entire buffer */
 	a = (float *)m_e_cb->peek(&e_count);
 	if (e_count == 0)
@@ -357,7 +364,7 @@ unsigned int fcch_detector::scan(const complex *s, const unsigned int s_len,
 	limit = 0.7 * avg;
 
 	if (g_debug) {
-		printf("debug: error limit: %.1lf\n", limit);
+		log_async(stdout, "debug: error limit: %.1lf\n", limit);
 	}
 
 	/* Find neighborhoods where error is smaller than limit */
@@ -379,8 +386,17 @@ unsigned int fcch_detector::scan(const complex *s, const unsigned int s_len,
 			y = s + y_offset;
 
 			loff = freq_detect(y, y_len, &pm);
+			KAL_PROBE3(fcch_candidate, l_count, KAL_PROBE_MILLI(pm), KAL_PROBE_MILLI(loff));
+			/* When full, keep overwriting the last slot so it stays the latest */
+			if (m_cand_count < FCCH_MAX_CANDIDATES)
+				m_cand_count++;
+			else
+				m_cand_dropped++;
+			m_cand[m_cand_count - 1].pos = y_offset;
+			m_cand[m_cand_count - 1].pm = pm;
+			m_cand[m_cand_count - 1].offset = loff;
 			if (g_debug)
-				printf("debug: %.0f\t%f\t%f\n", (double)l_count / sps, pm, loff);
+				log_async(stdout, "debug: %.0f\t%f\t%f\n", (double)l_count / sps, pm, loff);
 
 			if (pm > MIN_PM)
 				break;
@@ -399,7 +415,7 @@ unsigned int fcch_detector::scan(const complex *s, const unsigned int s_len,
 		*offset = loff;
 
 	if (g_debug) {
-		printf("debug: fcch_detector finished -----------------------------\n");
+		log_async(stdout, "debug: fcch_detector finished -----------------------------\n");
 	}
 
 	return 1;
@@ -474,6 +490,15 @@ unsigned int fcch_detector::update(const complex *s, const unsigned int s_len)
 	return m_x_cb->write(s, s_len);
 }
 
+unsigned int fcch_detector::candidates(const fcch_candidate **c, unsigned int *dropped)
+{
+	if (c)
+		*c = m_cand;
+	if (dropped)
+		*dropped = m_cand_dropped;
+	return m_cand_count;
+}
+
 unsigned int fcch_detector::get_delay()
 {
 	return m_w_len - 1 + m_D;
@@ -24,6 +24,16 @@ typedef std::complex<float> complex;
 /** @brief FFT size for frequency detection. */
 #define FFT_SIZE 1024
 
+/** @brief Maximum number of candidates kept per scan() call. */
+#define FCCH_MAX_CANDIDATES 32
+
+/** @brief One low-error region evaluated by scan(). */
+struct fcch_candidate {
+	unsigned int pos;   /**< Start sample in the scanned buffer */
+	float pm;           /**< Peak-to-mean ratio */
+	float offset;       /**< Detected tone frequency (Hz, not corrected) */
+};
+
 /**
  * @class fcch_detector
  * @brief Detects GSM Frequency Correction Channel bursts.
@@ -80,6 +90,18 @@ public:
 	 */
 	int next_norm_error(float *error);
 
+	/**
+	 * @brief Candidates evaluated by the last scan() call.
+	 *
+	 * When scan() returned 1 the last candidate is the reported one.
+	 * Past FCCH_MAX_CANDIDATES the last slot is overwritten; the number of
+	 * overwritten candidates is returned in @p dropped.
+	 * @param c       Output: pointer to the candidate array.
+	 * @param dropped Output: candidates not kept (may be NULL).
+	 * @return Number of candidates.
+	 */
+	unsigned int candidates(const fcch_candidate **c, unsigned int *dropped = 0);
+
 	/** @brief Returns adaptive filter delay. */
 	unsigned int get_delay();
 
@@ -125,6 +147,11 @@ private:
 	unsigned int m_lth_count;  /**< Sample counter for edge detection */
 	unsigned int m_lth_state;  /**< Current state (LOW or HIGH) */
 
+	/* Candidates of the last scan() */
+	fcch_candidate m_cand[FCCH_MAX_CANDIDATES];
+	unsigned int m_cand_count;
+	unsigned int m_cand_dropped;
+
 	/** @brief Resets edge detection state machine. */
 	void low_to_high_init();
 
@@ -40,6 +40,7 @@
 #include <iostream>
 
 #include "iio_source.h"
+#include "kal_probes.h"
 
 extern volatile sig_atomic_t g_kal_exit_req;
 
@@ -53,6 +54,11 @@ iio_source::iio_source(float gain, const char* uri)
 	m_center_freq = 0.0;
 	m_freq_corr = 0;
 	m_overflow_count = 0;
+	m_samples_written = 0;
+	m_write_seq = 0;
+	m_tune_gen = 0;
+	m_tuned_freq = 0.0;
+	m_ppm_corr = 0.0;
 
 	m_ctx = NULL;
 	m_dev = NULL;
@@ -136,13 +142,22 @@ int iio_source::close()
 	return 0;
 }
 
-int iio_source::tune(double freq)
+/**
+ * @brief Tunes the LO to @p freq + @p lo_shift, with the ppm correction.
+ *
+ * tuned_freq() keeps reporting @p freq, so a shifted LO (coarse
+ * acquisition search steps) still logs the channel being measured.
+ */
+int iio_source::tune(double freq, double lo_shift)
 {
 	if (!m_phy) return -1;
 
-	long long freq_ll = (long long)freq;
+	// Apply the coarse TCXO correction (0 unless acquired)
+	long long freq_ll = (long long)((freq + lo_shift) * (1.0 + m_ppm_corr * 1e-6));
+	KAL_PROBE1(tune_begin, freq_ll);
 	if (iio_channel_attr_write_longlong(iio_device_find_channel(m_phy, "altvoltage0", true), "frequency", freq_ll) < 0) {
 		fprintf(stderr, "Failed to tune to %.0f Hz\n", freq);
+		KAL_PROBE2(tune_end, freq_ll, -1);
 		return -1;
 	}
 	else
@@ -151,7 +166,10 @@ int iio_source::tune(double freq)
 		iio_channel_attr_read_longlong(iio_device_find_channel(m_phy, "altvoltage0", true), "frequency", &freq_ll);
 	}
 	m_center_freq = (double)freq_ll;
+	m_tuned_freq = freq;
+	m_tune_gen++;
 	m_resampler->reset();
+	KAL_PROBE2(tune_end, freq_ll, 0);
 	return 0;
 }
 
@@ -219,6 +237,7 @@ void iio_source::worker_thread()
 	while (streaming.load()) {
 		ssize_t nbytes = iio_buffer_refill(m_rxbuf);
 		if (nbytes < 0) break;
+		KAL_PROBE1(iio_refill, (long long)nbytes);
 
 		void *start = iio_buffer_first(m_rxbuf, m_rx0_i);
 		void *end = iio_buffer_end(m_rxbuf);
@@ -237,19 +256,29 @@ void iio_source::worker_thread()
 		// But dsp_resampler expects separate input/output buffers.
 		// Let's allocate a temp output buffer on stack or class
 		std::complex<float> out_buf[BATCH_SIZE];
+		KAL_PROBE1(resample_start, count);
 		size_t produced = m_resampler->process(m_batch_buffer, count, out_buf, BATCH_SIZE);
+		KAL_PROBE2(resample_end, count, produced);
 
 		if (produced > 0) {
 			std::unique_lock<std::mutex> lock(data_mutex, std::defer_lock);
 			if (lock.try_lock()) {
 				if (cb) {
+					m_write_seq++;
 					unsigned int written = cb->write(out_buf, produced);
-					if (written < produced) m_overflow_count += (produced - written);
+					m_samples_written += written;
+					m_write_seq++;
+					KAL_PROBE2(ring_write, produced, written);
+					if (written < produced) {
+						m_overflow_count += (produced - written);
+						KAL_PROBE1(ring_overflow, produced - written);
+					}
 				}
 				lock.unlock();
 				data_ready.notify_one();
 			} else {
 				m_overflow_count += produced;
+				KAL_PROBE1(ring_overflow, produced);
 			}
 		}
 	}
@@ -260,15 +289,34 @@ int iio_source::fill(unsigned int num_samples, unsigned int *overruns)
 	if (!cb) return -1;
 	if (!streaming.load()) start();
 
+	unsigned int available = 0;
 	std::unique_lock<std::mutex> lock(data_mutex);
 	while (true) {
 		if (g_kal_exit_req) return -1;
-		if ((cb->data_available() >= num_samples) || !streaming.load()) break;
+		available = cb->data_available();
+		if ((available >= num_samples) || !streaming.load()) break;
 		data_ready.wait_for(lock, std::chrono::milliseconds(100));
 	}
 	if (!streaming.load()) return -1;
+	KAL_PROBE2(fill_wake, num_samples, available);
 	if (overruns) *overruns = m_overflow_count.exchange(0);
 	return 0;
 }
 
+unsigned long long iio_source::read_position()
+{
+	if (!cb) return 0;
+	// Seqlock read: never contend data_mutex with the worker (it only
+	// try_locks, so a busy mutex would turn a whole batch into overflow)
+	unsigned int seq;
+	unsigned long long written;
+	unsigned int available;
+	do {
+		seq = m_write_seq.load();
+		written = m_samples_written.load();
+		available = cb->data_available();
+	} while ((seq & 1) || seq != m_write_seq.load());
+	return written - available;
+}
+
 int iio_source::flush() { if (cb) cb->flush(); m_overflow_count = 0; return 0; }
\ No newline at end of file
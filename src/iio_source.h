@@ -61,7 +61,7 @@ public:
 	~iio_source();
 
 	int open();
-	int tune(double freq);
+	int tune(double freq, double lo_shift = 0.0);
 	int set_gain(float gain);
 	int start();
 	int stop();
@@ -70,6 +70,20 @@ public:
 
 	inline double sample_rate() { return m_sample_rate; }
 	inline circular_buffer* get_buffer() { return cb; }
+	inline float gain() { return m_gain; }
+	/** @brief Last frequency passed to tune(), before LO shift and ppm correction. */
+	inline double tuned_freq() { return m_tuned_freq; }
+	/**
+	 * @brief Pre-corrects all subsequent tune() calls.
+	 * @param ppm Measured error (offset / frequency, same sign as the
+	 *            "Average Error" report); the LO is set to freq * (1 + ppm).
+	 */
+	inline void set_ppm_correction(double ppm) { m_ppm_corr = ppm; }
+	inline double ppm_correction() { return m_ppm_corr; }
+	/** @brief Incremented on every successful tune(). */
+	inline unsigned int tune_generation() { return m_tune_gen; }
+	/** @brief Stream index of the first sample currently in the buffer. */
+	unsigned long long read_position();
 
 	int fill(unsigned int num_samples, unsigned int *overruns);
 	int flush();
@@ -94,6 +108,11 @@ private:
 	float m_gain;
 	double m_sample_rate;
 	std::atomic<unsigned int> m_overflow_count;
+	std::atomic<unsigned long long> m_samples_written;
+	std::atomic<unsigned int> m_write_seq; /**< Odd while a ring write is in progress */
+	unsigned int m_tune_gen;
+	double m_tuned_freq;
+	double m_ppm_corr;
 	dsp_resampler* m_resampler;
 	std::string m_uri;
 
@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <libgen.h>
+#include <getopt.h>
 #endif
 
 #include "iio_source.h"
@@ -33,10 +34,16 @@
 #include "offset.h"
 #include "c0_detect.h"
 #include "util.h"
+#include "async_log.h"
+#include "burst_log.h"
 
 int g_verbosity = 0;
 int g_debug = 0;
 int g_show_fft = 0;
+int g_coarse_acquire = 1;
+
+// Binary FCCH candidate log (--burst-log), NULL when disabled
+burst_log *g_burst_log = NULL;
 
 // Global control flags for signal handling
 volatile sig_atomic_t g_kal_exit_req = 0;
@@ -71,6 +78,12 @@ void usage(char *prog) {
 	fprintf(stderr, "\t-g\tgain (dB)\n");
 	fprintf(stderr, "\t-u\tIIO URI (e.g. ip:192.168.2.1 or usb:x.y.z)\n");
 	fprintf(stderr, "\t-A\tShow ASCII FFT of signal\n");
+	fprintf(stderr, "\t--max-found K\tstop scan after K base stations are confirmed\n");
+	fprintf(stderr, "\t--first\tstop scan at the first confirmed base station\n");
+	fprintf(stderr, "\t--no-acquire\tskip coarse TCXO error acquisition\n");
+	fprintf(stderr, "\t--burst-log FILE\tlog every FCCH candidate to a binary file (+ FILE.idx)\n");
+	fprintf(stderr, "\t--dump-log FILE\tprint a burst log as CSV (filter with -c, --from, --to) and exit\n");
+	fprintf(stderr, "\t--from T, --to T\tburst log time range (seconds since epoch)\n");
 	fprintf(stderr, "\t-B\tRun DSP Benchmark and exit\n");
 	fprintf(stderr, "\t-v\tverbose\n");
 	fprintf(stderr, "\t-D\tenable debug messages\n");
@@ -88,6 +101,10 @@ int main(int argc, char **argv) {
 	double freq = -1.0;
 	int result = 0;
 	char *uri = NULL;
+	unsigned int max_found = 0;
+	char *burst_log_path = NULL;
+	char *dump_log_path = NULL;
+	uint64_t dump_from_us = 0, dump_to_us = UINT64_MAX;
 	
 	iio_source *u = NULL;
 
@@ -106,7 +123,18 @@ int main(int argc, char **argv) {
 	signal(SIGINT, sighandler);
 #endif
 
-	while((c = getopt(argc, argv, "f:c:s:b:g:u:vDBAh?")) != EOF) {
+	static const struct option long_opts[] = {
+		{ "max-found", required_argument, 0, 'K' },
+		{ "first",     no_argument,       0, '1' },
+		{ "no-acquire", no_argument,      0, 'N' },
+		{ "burst-log", required_argument, 0, 'L' },
+		{ "dump-log",  required_argument, 0, 'P' },
+		{ "from",      required_argument, 0, 'F' },
+		{ "to",        required_argument, 0, 'T' },
+		{ 0, 0, 0, 0 }
+	};
+
+	while((c = getopt_long(argc, argv, "f:c:s:b:g:u:vDBAh?", long_opts, 0)) != EOF) {
 		switch(c) {
 			case 'f':
 				freq = strtod(optarg, 0);
@@ -139,6 +167,27 @@ int main(int argc, char **argv) {
 			case 'A':
 				g_show_fft = 1;
 				break;
+			case 'K':
+				max_found = strtoul(optarg, 0, 0);
+				break;
+			case '1':
+				max_found = 1;
+				break;
+			case 'N':
+				g_coarse_acquire = 0;
+				break;
+			case 'L':
+				burst_log_path = optarg;
+				break;
+			case 'P':
+				dump_log_path = optarg;
+				break;
+			case 'F':
+				dump_from_us = (uint64_t)(strtod(optarg, 0) * 1e6);
+				break;
+			case 'T':
+				dump_to_us = (uint64_t)(strtod(optarg, 0) * 1e6);
+				break;
 			case 'v':
 				g_verbosity++;
 				break;
@@ -153,6 +202,10 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	if(dump_log_path) {
+		return burst_log_dump(dump_log_path, chan, dump_from_us, dump_to_us);
+	}
+
 	if(bts_scan) {
 		if(bi == BI_NOT_DEFINED) {
 			fprintf(stderr, "error: scanning requires band (-s)\n");
@@ -176,15 +229,30 @@ int main(int argc, char **argv) {
 		printf("debug: Gain                 : %f\n", gain);
 	}
 
+	if(burst_log_path) {
+		g_burst_log = new burst_log();
+		if(g_burst_log->open(burst_log_path) == -1) {
+			delete g_burst_log;
+			return -1;
+		}
+	}
+
+	// Hot-path diagnostics are written by a background thread
+	log_start();
+
 	u = new iio_source(gain, uri);
 	if(!u) {
 		fprintf(stderr, "error: failed to allocate iio_source\n");
+		log_stop();
+		delete g_burst_log;
 		return -1;
 	}
 
 	if(u->open() == -1) {
 		fprintf(stderr, "error: failed to open IIO device\n");
 		delete u;
+		log_stop();
+		delete g_burst_log;
 		return -1;
 	}
 
@@ -206,11 +274,13 @@ int main(int argc, char **argv) {
 
 	fprintf(stderr, "%s: Scanning for %s base stations.\n", basename(argv[0]), bi_to_str(bi));
 
-	result = c0_detect(u, bi);
+	result = c0_detect(u, bi, max_found);
 
 cleanup:
 	if(u) {
 		delete u;
 	}
+	log_stop();
+	delete g_burst_log;
 	return result;
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file kal_probes.h
+ * @brief USDT static tracepoints for production tracing (perf/bpftrace).
+ *
+ * Enabled with the CMake option KAL_ENABLE_USDT, which defines KAL_USDT
+ * when <sys/sdt.h> (systemtap-sdt-dev) is available. Each probe compiles
+ * to a single nop plus an ELF note; it costs nothing until a tracer
+ * attaches. Without KAL_USDT the macros expand to nothing.
+ * Probe arguments are always evaluated, so only pass values that are
+ * already computed (no locks or function calls).
+ *
+ * All probes use provider "kal". Floating point values are passed as
+ * scaled integers (milli-units) so every tracer can read them.
+ *
+ * @code
+ *   sudo bpftrace -e 'usdt:./kal:kal:fill_wake { @[probe] = count(); }'
+ *   sudo bpftrace -l 'usdt:./kal:kal:*'
+ * @endcode
+ *
+ * Probes:
+ * - iio_refill(nbytes)                             IIO buffer refill completed
+ * - resample_start(in_samples)                     DSP block start
+ * - resample_end(in_samples, out_samples)          DSP block end
+ * - ring_write(produced, written)                  Samples pushed to the ring buffer
+ * - ring_overflow(dropped)                         Samples dropped (full ring or lock busy)
+ * - fill_wake(requested, available)                Consumer fill() returns with data
+ * - tune_begin(freq_hz)                            LO retune requested
+ * - tune_end(freq_hz, rc)                          LO retune done (actual frequency)
+ * - fcch_candidate(len, pm_milli, offset_millihz)  FCCH candidate evaluated
+ * - burst_accept(count, offset_millihz)            offset_detect() accepted a burst
+ * - burst_reject(offset_millihz)                   offset_detect() rejected a burst (range)
+ * - burst_notfound(iteration)                      offset_detect() found no burst in frame
+ *
+ * @author agent <agent@local>
+ * @copyright 2026 agent
+ * @license BSD-2-Clause
+ */
+
+#ifndef __KAL_PROBES_H__
+#define __KAL_PROBES_H__
+
+#if defined(KAL_USDT)
+	#include <sys/sdt.h>
+	#define KAL_PROBE1(name, a)       DTRACE_PROBE1(kal, name, a)
+	#define KAL_PROBE2(name, a, b)    DTRACE_PROBE2(kal, name, a, b)
+	#define KAL_PROBE3(name, a, b, c) DTRACE_PROBE3(kal, name, a, b, c)
+#else
+	#define KAL_PROBE1(name, a)       do { } while (0)
+	#define KAL_PROBE2(name, a, b)    do { } while (0)
+	#define KAL_PROBE3(name, a, b, c) do { } while (0)
+#endif
+
+/** @brief Scales a float to a milli-unit integer for probe arguments. */
+#define KAL_PROBE_MILLI(x) ((long long)((x) * 1000.0))
+
+#endif /* __KAL_PROBES_H__ */
@@ -26,24 +26,142 @@ inline double round(double x) { return floor(x + 0.5); }
 
 #include "iio_source.h"
 #include "fcch_detector.h"
+#include "offset.h"
 #include "circular_buffer.h"
 #include "util.h"
+#include "async_log.h"
+#include "burst_log.h"
+#include "kal_probes.h"
 
 static const unsigned int TARGET_COUNT = 100; // We want 100 good samples
 static const unsigned int MAX_ITERATIONS = 500; // But quit if we process 500 frames without success
 static const float OFFSET_MAX = 40e3;
 
+/*
+ * Coarse acquisition: the resampler passband ends at 100 kHz, so the
+ * FCCH tone (GSM_RATE/4 = 67.7 kHz + error) is only measured cleanly for
+ * errors within ~ +/-30 kHz of the LO. Larger errors (20 ppm is 36 kHz
+ * at DCS-1800) are reached by stepping the LO in ACQ_STEP_HZ steps, which
+ * covers +/- (2 * ACQ_STEP_HZ + ACQ_WINDOW) = +/-130 kHz.
+ */
+static const float ACQ_STEP_HZ = 50e3;
+static const int ACQ_STEPS[ACQ_LO_STEPS] = { 0, -1, 1, -2, 2 };
+static const float ACQ_WINDOW = 30e3;
+static const unsigned int ACQ_STEP_CAPTURES = 4;   // Captures before giving up on a step
+static const unsigned int ACQ_TARGET_COUNT = 3;    // Detections for the median
+static const unsigned int ACQ_MAX_ITERATIONS = 10; // Captures on a step that has hits
+static const float ACQ_APPLY_MIN = 1e3; // Below this, the fine search is already centred
+
 extern int g_verbosity;
 extern int g_show_fft;
 extern volatile sig_atomic_t g_kal_exit_req;
+extern burst_log *g_burst_log;
+extern int g_coarse_acquire;
+
+#define GSM_RATE (1625000.0 / 6.0)
+
+double acq_lo_shift(unsigned int k) {
+	return (k < ACQ_LO_STEPS) ? ACQ_STEPS[k] * ACQ_STEP_HZ : 0.0;
+}
+
+int coarse_acquire(iio_source *u, fcch_detector *d) {
+	unsigned int overruns, b_len, s_len, count = 0, iterations, r;
+	unsigned long long b_pos;
+	float f, shift = 0.0f, offsets[ACQ_TARGET_COUNT];
+	double ppm, freq = u->tuned_freq();
+	complex *b;
+	circular_buffer *cb = u->get_buffer();
+
+	s_len = (unsigned int)ceil((12 * 8 * 156.25 + 156.25) * (u->sample_rate() / GSM_RATE));
+
+	// Called from the c0_detect() sweep: keep its queued lines ahead of ours
+	log_flush();
+
+	for(unsigned int k = 0; k < ACQ_LO_STEPS; k++) {
+		shift = acq_lo_shift(k);
+		if(u->tune(freq, shift) != 0) {
+			if (g_kal_exit_req) return ACQ_NOT_FOUND;
+			fprintf(stderr, "error: iio_source::tune\n");
+			return ACQ_SOURCE_ERROR;
+		}
+
+		count = 0;
+		for(iterations = 0; iterations < ACQ_MAX_ITERATIONS && count < ACQ_TARGET_COUNT; iterations++) {
+			if (g_kal_exit_req) return ACQ_NOT_FOUND;
+			// No hit at all on this step: move on
+			if (count == 0 && iterations >= ACQ_STEP_CAPTURES)
+				break;
+
+			do {
+				u->flush();
+				if(u->fill(s_len, &overruns)) {
+					if (g_kal_exit_req) return ACQ_NOT_FOUND;
+					fprintf(stderr, "error: iio_source::fill\n");
+					return ACQ_SOURCE_ERROR;
+				}
+			} while(overruns);
+
+			b_pos = g_burst_log ? u->read_position() : 0;
+			b = (complex *)cb->peek(&b_len);
+			r = d->scan(b, b_len, &f, 0);
+			if (g_burst_log) {
+				g_burst_log->log_scan(d, u, b_pos, r, GSM_RATE / 4, ACQ_WINDOW,
+						      BURST_SRC_ACQUIRE, shift);
+			}
+			if(!r)
+				continue;
+
+			f -= GSM_RATE / 4;
+			if(fabsf(f) < ACQ_WINDOW)
+				offsets[count++] = f + shift; // Offset from the carrier
+		}
+
+		if(count >= ACQ_TARGET_COUNT)
+			break;
+	}
+
+	if(count < ACQ_TARGET_COUNT) {
+		if(g_verbosity > 0) {
+			fprintf(stderr, "coarse acquisition: no FCCH at %.1fMHz\n", freq / 1e6);
+		}
+		if(u->tune(freq) != 0) {
+			if (g_kal_exit_req) return ACQ_NOT_FOUND;
+			fprintf(stderr, "error: iio_source::tune\n");
+			return ACQ_SOURCE_ERROR;
+		}
+		return ACQ_NOT_FOUND;
+	}
+
+	sort(offsets, count);
+	f = offsets[count / 2];
+	ppm = u->ppm_correction() + f / freq * 1e6;
+
+	if(fabsf(f) < ACQ_APPLY_MIN) {
+		if(g_verbosity > 0) {
+			fprintf(stderr, "coarse acquisition: %+.0f Hz at %.1fMHz, no correction needed\n",
+				f, freq / 1e6);
+		}
+	} else {
+		fprintf(stderr, "coarse acquisition: %+.1f kHz at %.1fMHz (%+.2f ppm), pre-correcting LO\n",
+			f / 1e3, freq / 1e6, ppm);
+		u->set_ppm_correction(ppm);
+	}
+
+	// Back on the carrier (with any new correction)
+	if(u->tune(freq) != 0) {
+		if (g_kal_exit_req) return ACQ_NOT_FOUND;
+		fprintf(stderr, "error: iio_source::tune\n");
+		return ACQ_SOURCE_ERROR;
+	}
+	u->flush();
+	return (fabsf(f) < ACQ_APPLY_MIN) ? ACQ_NOT_NEEDED : ACQ_APPLIED;
+}
 
 /**
  * @brief Calculates the frequency offset by averaging multiple FCCH detections.
  */
 int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 
-#define GSM_RATE (1625000.0 / 6.0)
-
 	unsigned int new_overruns = 0, overruns = 0;
 	unsigned int notfound = 0;
 	unsigned int s_len, b_len, consumed = 0;
@@ -71,6 +189,22 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 
 	u->start();
 	u->flush();
+
+	// Bring a badly off TCXO into the fine search window first
+	if (g_coarse_acquire && u->ppm_correction() == 0.0) {
+		int acq = coarse_acquire(u, l);
+		if (g_kal_exit_req) {
+			u->stop();
+			delete l;
+			return 0;
+		}
+		if (acq == ACQ_SOURCE_ERROR) {
+			fprintf(stderr, "Error: coarse acquisition failed.\n");
+			u->stop();
+			delete l;
+			return -1;
+		}
+	}
 	
 	if (g_verbosity == 0) {
 		printf("Scanning for FCCH bursts ('.' = searching, '+' = found)\n");
@@ -100,6 +234,7 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 		if (g_kal_exit_req) break;
 
 		// 2. Peek at data
+		unsigned long long b_pos = g_burst_log ? u->read_position() : 0;
 		cbuf = (complex *)cb->peek(&b_len);
 
 		// FFT VISUALIZATION
@@ -113,7 +248,12 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 		}
 
 		// 3. Scan for FCCH
-		if(l->scan(cbuf, b_len, &offset, &consumed)) {
+		unsigned int found = l->scan(cbuf, b_len, &offset, &consumed);
+		if (g_burst_log) {
+			g_burst_log->log_scan(l, u, b_pos, found, GSM_RATE / 4 + tuner_error,
+					      OFFSET_MAX, BURST_SRC_OFFSET);
+		}
+		if(found) {
 			// FOUND!
 			
 			// FCCH is a sine wave at GSM_RATE / 4 (approx 67.7 kHz)
@@ -123,27 +263,28 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 			if(fabs(offset) < OFFSET_MAX) {
 				offsets[count] = offset;
 				count++;
+				KAL_PROBE2(burst_accept, count, KAL_PROBE_MILLI(offset));
 
 				if(g_verbosity > 0) {
-					fprintf(stderr, "  [%3u/%u] Offset: %+.2f Hz\n", count, TARGET_COUNT, offset);
+					log_async(stderr, "  [%3u/%u] Offset: %+.2f Hz\n", count, TARGET_COUNT, offset);
 				} else {
 					// Visual heartbeat
-					fprintf(stderr, "+"); 
-					fflush(stderr);
+					log_async(stderr, "+");
 				}
 			} else {
 				// Found something, but offset was crazy
-				if(g_verbosity > 0) fprintf(stderr, "  [Ignored] Offset %.2f Hz out of range\n", offset);
+				KAL_PROBE1(burst_reject, KAL_PROBE_MILLI(offset));
+				if(g_verbosity > 0) log_async(stderr, "  [Ignored] Offset %.2f Hz out of range\n", offset);
 			}
 		} else {
 			// NOT FOUND
 			notfound++;
+			KAL_PROBE1(burst_notfound, iterations);
 			
 			if(g_verbosity > 0) {
-			    fprintf(stderr, "  [---] No FCCH found in frame %u\n", iterations);
+			    log_async(stderr, "  [---] No FCCH found in frame %u\n", iterations);
 			} else {
-				fprintf(stderr, ".");
-				fflush(stderr);
+				log_async(stderr, ".");
 			}
 
 			// IMPORTANT: If scan failed, it might not set 'consumed'.
@@ -158,6 +299,7 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 	}
 	
 	// End of loop cleanup
+	log_flush();
 	if (g_verbosity == 0) fprintf(stderr, "\n"); // Newline after dots
 	u->stop();
 	delete l;
@@ -201,7 +343,11 @@ int offset_detect(iio_source *u, int hz_adjust, float tuner_error) {
 
 	// PPM Calculation
 	// Formula: PPM = (Offset_Hz / Center_Freq_Hz) * 1e6
-	total_ppm = ((avg_offset + hz_adjust) / u->m_center_freq) * 1000000.0;
+	// plus any coarse correction already applied to the LO
+	total_ppm = ((avg_offset + hz_adjust) / u->m_center_freq) * 1000000.0 + u->ppm_correction();
+	if (u->ppm_correction() != 0.0) {
+		printf("coarse correction: %.3f ppm (included below)\n", u->ppm_correction());
+	}
 
 	printf("\nAverage Error: %.3f ppm (%.3f ppb)\n", total_ppm, total_ppm * 1000.0);
 
@@ -30,4 +30,41 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-int offset_detect(iio_source *u, int hz_adjust, float tuner_error);
\ No newline at end of file
+#ifndef __OFFSET_H__
+#define __OFFSET_H__
+
+/** @brief coarse_acquire() results. */
+enum {
+	ACQ_SOURCE_ERROR = -2,  /**< fill()/tune() failed: abort */
+	ACQ_NOT_FOUND = -1,     /**< No FCCH on this carrier */
+	ACQ_NOT_NEEDED = 0,     /**< Error already inside the fine window */
+	ACQ_APPLIED = 1         /**< LO pre-correction applied */
+};
+
+/** @brief Number of LO steps searched by coarse_acquire(). */
+#define ACQ_LO_STEPS 5
+
+int offset_detect(iio_source *u, int hz_adjust, float tuner_error);
+
+/**
+ * @brief LO shift (Hz) of coarse_acquire() search step @p k.
+ *
+ * Step 0 is the carrier itself; the other steps alternate below and above
+ * it. Returns 0 for k >= ACQ_LO_STEPS.
+ */
+double acq_lo_shift(unsigned int k);
+
+/**
+ * @brief Coarse TCXO error acquisition on the currently tuned carrier.
+ *
+ * Steps the LO around the carrier (0, -/+ACQ_STEP_HZ, -/+2*ACQ_STEP_HZ)
+ * and runs the FCCH detector in a +/- ACQ_WINDOW window at each step, so
+ * the tone always stays inside the resampler passband. When the median
+ * offset exceeds ACQ_APPLY_MIN, all subsequent tunes are pre-corrected.
+ * The LO is left on the (corrected) carrier.
+ *
+ * @return ACQ_APPLIED, ACQ_NOT_NEEDED, ACQ_NOT_FOUND or ACQ_SOURCE_ERROR.
+ */
+int coarse_acquire(iio_source *u, fcch_detector *d);
+
+#endif /* __OFFSET_H__ */
\ No newline at end of file